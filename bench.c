@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <time.h>
+#include "vector.h"
+
+/**
+ * Benchmark of VECTOR_PACKED against VECTOR on sorted and random data.
+ *
+ * Build and run:
+ * ```sh
+ * gcc -O2 bench.c -o bench && ./bench
+ * ```
+ */
+
+#define BENCH_SIZE (1 << 22)
+#define BENCH_REPEAT 10
+
+VECTOR(int, vector_int, NULL, NULL);
+VECTOR(long long, vector_long, NULL, NULL);
+VECTOR_PACKED(int, vector_packed_int);
+VECTOR_PACKED(long long, vector_packed_long);
+
+long long bench_sum = 0;
+void bench_add_int(int n)
+{
+    bench_sum += n;
+}
+void bench_add_long(long long n)
+{
+    bench_sum += n;
+}
+
+double elapsed_ms(clock_t start)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, size_t plain_bytes, size_t packed_bytes, double plain_scan, double packed_scan,
+            double plain_sum, double packed_sum, double plain_at, double packed_at)
+{
+    printf("%-16s memory %6zu -> %6zu KiB (%5.2fx)  foreach %6.2f -> %6.2f ms  sum %6.2f -> %6.2f ms"
+           "  at %7.2f -> %7.2f ms\n",
+           name, plain_bytes / 1024, packed_bytes / 1024, (double)plain_bytes / packed_bytes,
+           plain_scan, packed_scan, plain_sum, packed_sum, plain_at, packed_at);
+}
+
+#define BENCH(__NAME__, __PLAIN__, __PACKED__, __TYPE__, __ADD__, __GENERATOR__)             \
+    {                                                                                        \
+        __PLAIN__ *plain = new_##__PLAIN__();                                                \
+        __PACKED__ *packed = new_##__PACKED__();                                             \
+        __TYPE__ value = 0;                                                                  \
+        for (size_t i = 0; i < BENCH_SIZE; ++i)                                              \
+        {                                                                                    \
+            value = (__GENERATOR__);                                                         \
+            plain->push(plain, value);                                                       \
+            packed->push(packed, value);                                                     \
+        }                                                                                    \
+        plain->optimize_memory(plain);                                                       \
+        packed->optimize_memory(packed);                                                     \
+                                                                                             \
+        long long expected = 0;                                                              \
+        clock_t start = clock();                                                             \
+        for (int r = 0; r < BENCH_REPEAT; ++r)                                               \
+        {                                                                                    \
+            bench_sum = 0;                                                                   \
+            plain->foreach(plain, __ADD__);                                                  \
+        }                                                                                    \
+        double plain_scan = elapsed_ms(start) / BENCH_REPEAT;                                \
+        expected = bench_sum;                                                                \
+        start = clock();                                                                     \
+        for (int r = 0; r < BENCH_REPEAT; ++r)                                               \
+        {                                                                                    \
+            bench_sum = 0;                                                                   \
+            packed->foreach(packed, __ADD__);                                                \
+        }                                                                                    \
+        double packed_scan = elapsed_ms(start) / BENCH_REPEAT;                               \
+        assert(bench_sum == expected);                                                       \
+                                                                                             \
+        start = clock();                                                                     \
+        for (int r = 0; r < BENCH_REPEAT; ++r)                                               \
+        {                                                                                    \
+            bench_sum = 0;                                                                   \
+            for (size_t i = 0; i < plain->size; ++i)                                         \
+                bench_sum += plain->__data[i];                                               \
+        }                                                                                    \
+        double plain_sum = elapsed_ms(start) / BENCH_REPEAT;                                 \
+        assert(bench_sum == expected);                                                       \
+        start = clock();                                                                     \
+        for (int r = 0; r < BENCH_REPEAT; ++r)                                               \
+        {                                                                                    \
+            __TYPE__ values[VECTOR_PACKED_BLOCK];                                            \
+            bench_sum = 0;                                                                   \
+            for (size_t block = 0; block * VECTOR_PACKED_BLOCK < packed->size; ++block)      \
+            {                                                                                \
+                size_t count = packed->decode(packed, block, values);                        \
+                for (size_t i = 0; i < count; ++i)                                           \
+                    bench_sum += values[i];                                                  \
+            }                                                                                \
+        }                                                                                    \
+        double packed_sum = elapsed_ms(start) / BENCH_REPEAT;                                \
+        assert(bench_sum == expected);                                                       \
+                                                                                             \
+        start = clock();                                                                     \
+        bench_sum = 0;                                                                       \
+        for (size_t i = 0; i < BENCH_SIZE; ++i)                                              \
+            bench_sum += plain->at(plain, (i * 7919) % BENCH_SIZE);                          \
+        double plain_at = elapsed_ms(start);                                                 \
+        expected = bench_sum;                                                                \
+        start = clock();                                                                     \
+        bench_sum = 0;                                                                       \
+        for (size_t i = 0; i < BENCH_SIZE; ++i)                                              \
+            bench_sum += packed->at(packed, (i * 7919) % BENCH_SIZE);                        \
+        double packed_at = elapsed_ms(start);                                                \
+        assert(bench_sum == expected);                                                       \
+                                                                                             \
+        report(__NAME__, sizeof(__PLAIN__) + plain->__max_size * sizeof(__TYPE__),           \
+               packed->memory_usage(packed), plain_scan, packed_scan, plain_sum, packed_sum, \
+               plain_at, packed_at);                                                         \
+        plain->free_memory(plain);                                                           \
+        packed->free_memory(packed);                                                         \
+    }
+
+int main()
+{
+    srand(42);
+    printf("%d elements, foreach and sum (decode for packed) averaged over %d runs, "
+           "at with a strided access pattern\n",
+           BENCH_SIZE, BENCH_REPEAT);
+
+    BENCH("int sorted ids", vector_int, vector_packed_int, int, bench_add_int,
+          value + rand() % 16);
+    BENCH("int random", vector_int, vector_packed_int, int, bench_add_int,
+          rand());
+    BENCH("long timestamps", vector_long, vector_packed_long, long long, bench_add_long,
+          i == 0 ? 1700000000000LL : value + 1000 + rand() % 8);
+    BENCH("long random", vector_long, vector_packed_long, long long, bench_add_long,
+          ((long long)rand() << 31) ^ rand());
+    return 0;
+}
@@ -28,6 +28,9 @@ void _deconstructor(char *str)
 
 VECTOR(int, vector_int, NULL, NULL);
 VECTOR(char *, vector_charp, _strdup, _deconstructor);
+VECTOR_PACKED(int, vector_packed_int);
+VECTOR_PACKED(long long, vector_packed_long);
+VECTOR_PACKED(short, vector_packed_short);
 
 /* INT VECTOR */
 void TEST1()
@@ -342,6 +345,393 @@ void TEST7_SCOPED()
     vec->free_memory(vec);
 }
 
+//*PACKED VECTOR*//
+long long packed_sum = 0;
+void packed_add(long long n)
+{
+    packed_sum += n;
+}
+
+void TEST8()
+{
+    printf("TEST: %s\n", __func__);
+    vector_packed_int *vec = new_vector_packed_int();
+    int limit = rand_int(1000, 5000);
+    int *array = calloc(limit, sizeof(int));
+
+    assert(vec->empty(vec) == 1);
+    for (int i = 0; i < limit; ++i)
+    {
+        int k = rand_int(0, 4) == 0 ? rand_int(0, __INT32_MAX__ - 1) - rand_int(0, __INT32_MAX__ - 1) : rand_int(-20, 20);
+        if (i % 512 == 7)
+            k = __INT32_MAX__;
+        if (i % 512 == 8)
+            k = -__INT32_MAX__ - 1;
+
+        array[i] = k;
+        assert(vec->push(vec, k) == 1);
+    }
+    assert(vec->size == limit);
+
+    for (int i = 0; i < limit; ++i)
+        assert(vec->at(vec, i) == array[i]);
+    assert(vec->front(vec) == array[0]);
+    assert(vec->back(vec) == array[limit - 1]);
+
+    vec->clear(vec);
+    assert(vec->empty(vec) == 1);
+    vec->push(vec, 42);
+    assert(vec->at(vec, 0) == 42);
+
+    vec->clear(vec);
+    for (int i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+        vec->push(vec, (i % 16 < 8 ? i % 8 : 7 - i % 8) * 9);
+    assert(vec->__blocks_size == 1 && vec->__blocks[0].mode == VECTOR_PACKED_FOR);
+    for (int i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+        assert(vec->at(vec, i) == (i % 16 < 8 ? i % 8 : 7 - i % 8) * 9);
+
+    vector_packed_short *narrow = new_vector_packed_short();
+    short expected[3 * VECTOR_PACKED_BLOCK], values[VECTOR_PACKED_BLOCK];
+    for (int i = 0; i < 3 * VECTOR_PACKED_BLOCK; ++i)
+    {
+        expected[i] = (short)(i < VECTOR_PACKED_BLOCK ? -3 * i : rand_int(-32768, 32767));
+        narrow->push(narrow, expected[i]);
+    }
+    for (size_t block = 0; block < 3; ++block)
+    {
+        size_t count = narrow->decode(narrow, block, values);
+        for (size_t i = 0; i < count; ++i)
+            assert(values[i] == expected[block * VECTOR_PACKED_BLOCK + i] &&
+                   narrow->at(narrow, block * VECTOR_PACKED_BLOCK + i) == values[i]);
+    }
+    narrow->free_memory(narrow);
+
+    free(array);
+    vec->free_memory(vec);
+}
+
+void TEST8_SCOPED()
+{
+    printf("TEST: %s\n", __func__);
+    scoped vector_packed_int *vec = new_vector_packed_int();
+    int limit = rand_int(1000, 5000);
+    int *array = calloc(limit, sizeof(int));
+
+    assert(vec->empty(vec) == 1);
+    for (int i = 0; i < limit; ++i)
+    {
+        int k = rand_int(0, 4) == 0 ? rand_int(0, __INT32_MAX__ - 1) - rand_int(0, __INT32_MAX__ - 1) : rand_int(-20, 20);
+        if (i % 512 == 7)
+            k = __INT32_MAX__;
+        if (i % 512 == 8)
+            k = -__INT32_MAX__ - 1;
+
+        array[i] = k;
+        assert(vec->push(vec, k) == 1);
+    }
+    assert(vec->size == limit);
+
+    for (int i = 0; i < limit; ++i)
+        assert(vec->at(vec, i) == array[i]);
+    assert(vec->front(vec) == array[0]);
+    assert(vec->back(vec) == array[limit - 1]);
+
+    vec->clear(vec);
+    assert(vec->empty(vec) == 1);
+    vec->push(vec, 42);
+    assert(vec->at(vec, 0) == 42);
+
+    vec->clear(vec);
+    for (int i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+        vec->push(vec, (i % 16 < 8 ? i % 8 : 7 - i % 8) * 9);
+    assert(vec->__blocks_size == 1 && vec->__blocks[0].mode == VECTOR_PACKED_FOR);
+    for (int i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+        assert(vec->at(vec, i) == (i % 16 < 8 ? i % 8 : 7 - i % 8) * 9);
+
+    scoped vector_packed_short *narrow = new_vector_packed_short();
+    short expected[3 * VECTOR_PACKED_BLOCK], values[VECTOR_PACKED_BLOCK];
+    for (int i = 0; i < 3 * VECTOR_PACKED_BLOCK; ++i)
+    {
+        expected[i] = (short)(i < VECTOR_PACKED_BLOCK ? -3 * i : rand_int(-32768, 32767));
+        narrow->push(narrow, expected[i]);
+    }
+    for (size_t block = 0; block < 3; ++block)
+    {
+        size_t count = narrow->decode(narrow, block, values);
+        for (size_t i = 0; i < count; ++i)
+            assert(values[i] == expected[block * VECTOR_PACKED_BLOCK + i] &&
+                   narrow->at(narrow, block * VECTOR_PACKED_BLOCK + i) == values[i]);
+    }
+
+    free(array);
+}
+
+void TEST9()
+{
+    printf("TEST: %s\n", __func__);
+    vector_packed_long *vec = new_vector_packed_long();
+    int limit = rand_int(2000, 5000);
+    long long *array = calloc(limit, sizeof(long long));
+    long long timestamp = 1700000000000LL, sum = 0;
+
+    for (int i = 0; i < limit; ++i)
+    {
+        timestamp += i % 300 == 0 ? -rand_int(0, 1000) : rand_int(0, 3);
+        array[i] = timestamp;
+        sum += timestamp;
+        vec->push(vec, timestamp);
+    }
+
+    vec->optimize_memory(vec);
+    assert(vec->memory_usage(vec) < limit * sizeof(long long) / 3);
+
+    for (int i = 0; i < limit; ++i)
+        assert(vec->at(vec, i) == array[i]);
+
+    packed_sum = 0;
+    vec->foreach(vec, packed_add);
+    assert(packed_sum == sum);
+
+    long long values[VECTOR_PACKED_BLOCK];
+    for (size_t block = 0; block * VECTOR_PACKED_BLOCK < vec->size; ++block)
+    {
+        size_t count = vec->decode(vec, block, values);
+        assert(count == (vec->size - block * VECTOR_PACKED_BLOCK < VECTOR_PACKED_BLOCK ? vec->size % VECTOR_PACKED_BLOCK : VECTOR_PACKED_BLOCK));
+        for (size_t i = 0; i < count; ++i)
+            assert(values[i] == array[block * VECTOR_PACKED_BLOCK + i]);
+    }
+
+    vec->clear(vec);
+    for (int i = 0; i < limit; ++i)
+    {
+        timestamp -= rand_int(0, 3);
+        array[i] = timestamp;
+        vec->push(vec, timestamp);
+    }
+    for (size_t block = 0; block < vec->__blocks_size; ++block)
+        assert(vec->__blocks[block].anchor_width <= _packed_bit_width(3 * VECTOR_PACKED_BLOCK));
+    for (int i = 0; i < limit; ++i)
+        assert(vec->at(vec, i) == array[i]);
+
+    free(array);
+    vec->free_memory(vec);
+}
+
+void TEST9_SCOPED()
+{
+    printf("TEST: %s\n", __func__);
+    scoped vector_packed_long *vec = new_vector_packed_long();
+    int limit = rand_int(2000, 5000);
+    long long *array = calloc(limit, sizeof(long long));
+    long long timestamp = 1700000000000LL, sum = 0;
+
+    for (int i = 0; i < limit; ++i)
+    {
+        timestamp += i % 300 == 0 ? -rand_int(0, 1000) : rand_int(0, 3);
+        array[i] = timestamp;
+        sum += timestamp;
+        vec->push(vec, timestamp);
+    }
+
+    vec->optimize_memory(vec);
+    assert(vec->memory_usage(vec) < limit * sizeof(long long) / 3);
+
+    for (int i = 0; i < limit; ++i)
+        assert(vec->at(vec, i) == array[i]);
+
+    packed_sum = 0;
+    vec->foreach(vec, packed_add);
+    assert(packed_sum == sum);
+
+    long long values[VECTOR_PACKED_BLOCK];
+    for (size_t block = 0; block * VECTOR_PACKED_BLOCK < vec->size; ++block)
+    {
+        size_t count = vec->decode(vec, block, values);
+        assert(count == (vec->size - block * VECTOR_PACKED_BLOCK < VECTOR_PACKED_BLOCK ? vec->size % VECTOR_PACKED_BLOCK : VECTOR_PACKED_BLOCK));
+        for (size_t i = 0; i < count; ++i)
+            assert(values[i] == array[block * VECTOR_PACKED_BLOCK + i]);
+    }
+
+    vec->clear(vec);
+    for (int i = 0; i < limit; ++i)
+    {
+        timestamp -= rand_int(0, 3);
+        array[i] = timestamp;
+        vec->push(vec, timestamp);
+    }
+    for (size_t block = 0; block < vec->__blocks_size; ++block)
+        assert(vec->__blocks[block].anchor_width <= _packed_bit_width(3 * VECTOR_PACKED_BLOCK));
+    for (int i = 0; i < limit; ++i)
+        assert(vec->at(vec, i) == array[i]);
+
+    free(array);
+}
+
+//*VIEWS*//
+int view_sum = 0;
+void view_add(int n)
+{
+    view_sum += n;
+}
+int add_int(int a, int b)
+{
+    return a + b;
+}
+
+void TEST10()
+{
+    printf("TEST: %s\n", __func__);
+    vector_int *vec = new_vector_int();
+    int limit = rand_int(50, 500);
+    for (int i = 0; i < limit; ++i)
+        vec->push(vec, i);
+
+    int begin = rand_int(0, limit / 2), end = rand_int(limit / 2, limit);
+    vector_int_view slice = vec->slice(vec, begin, end);
+    assert(slice.size == end - begin);
+    for (int i = 0; i < slice.size; ++i)
+        assert(slice.at(&slice, i) == begin + i);
+    assert(slice.find(&slice, end - 1) == slice.size - 1);
+    assert(slice.find(&slice, limit) == slice.size);
+
+    int step = rand_int(1, 7);
+    vector_int_view strided = vec->strided(vec, begin, step);
+    assert(strided.size == (limit - begin + step - 1) / step);
+    for (int i = 0; i < strided.size; ++i)
+        assert(strided.at(&strided, i) == begin + i * step);
+    assert(strided.back(&strided) == vec->at(vec, begin + (strided.size - 1) * step));
+
+    vector_int_view inner = strided.slice(&strided, 1, strided.size);
+    vector_int_view every_other = inner.strided(&inner, 0, 2);
+    for (int i = 0; i < every_other.size; ++i)
+        assert(every_other.at(&every_other, i) == begin + (1 + i * 2) * step);
+
+    vector_int_view empty = vec->slice(vec, limit, limit);
+    vector_int_view single = vec->strided(vec, begin, SIZE_MAX);
+    vector_int_view nested = strided.strided(&strided, 0, SIZE_MAX);
+    view_sum = 0;
+    empty.foreach(&empty, view_add);
+    single.foreach(&single, view_add);
+    nested.foreach(&nested, view_add);
+    assert(view_sum == 2 * begin);
+    assert(empty.empty(&empty) == 1 && single.size == 1 && nested.size == 1);
+    assert(vec->strided(vec, limit, SIZE_MAX).size == 0);
+    assert(single.slice(&single, 1, 1).size == 0 && single.strided(&single, 1, 1).size == 0);
+    assert(vec->find(vec, begin) == begin);
+
+    vec->free_memory(vec);
+}
+
+void TEST10_SCOPED()
+{
+    printf("TEST: %s\n", __func__);
+    scoped vector_int *vec = new_vector_int();
+    int limit = rand_int(50, 500);
+    for (int i = 0; i < limit; ++i)
+        vec->push(vec, i);
+
+    int begin = rand_int(0, limit / 2), end = rand_int(limit / 2, limit);
+    vector_int_view slice = vec->slice(vec, begin, end);
+    assert(slice.size == end - begin);
+    for (int i = 0; i < slice.size; ++i)
+        assert(slice.at(&slice, i) == begin + i);
+    assert(slice.find(&slice, end - 1) == slice.size - 1);
+    assert(slice.find(&slice, limit) == slice.size);
+
+    int step = rand_int(1, 7);
+    vector_int_view strided = vec->strided(vec, begin, step);
+    assert(strided.size == (limit - begin + step - 1) / step);
+    for (int i = 0; i < strided.size; ++i)
+        assert(strided.at(&strided, i) == begin + i * step);
+    assert(strided.back(&strided) == vec->at(vec, begin + (strided.size - 1) * step));
+
+    vector_int_view inner = strided.slice(&strided, 1, strided.size);
+    vector_int_view every_other = inner.strided(&inner, 0, 2);
+    for (int i = 0; i < every_other.size; ++i)
+        assert(every_other.at(&every_other, i) == begin + (1 + i * 2) * step);
+
+    vector_int_view empty = vec->slice(vec, limit, limit);
+    vector_int_view single = vec->strided(vec, begin, SIZE_MAX);
+    vector_int_view nested = strided.strided(&strided, 0, SIZE_MAX);
+    view_sum = 0;
+    empty.foreach(&empty, view_add);
+    single.foreach(&single, view_add);
+    nested.foreach(&nested, view_add);
+    assert(view_sum == 2 * begin);
+    assert(empty.empty(&empty) == 1 && single.size == 1 && nested.size == 1);
+    assert(vec->strided(vec, limit, SIZE_MAX).size == 0);
+    assert(single.slice(&single, 1, 1).size == 0 && single.strided(&single, 1, 1).size == 0);
+    assert(vec->find(vec, begin) == begin);
+}
+
+void TEST11()
+{
+    printf("TEST: %s\n", __func__);
+    vector_int *vec = new_vector_int();
+    int limit = rand_int(50, 500), total = 0;
+    for (int i = 0; i < limit; ++i)
+    {
+        int k = rand_int(-1000, 1000);
+        total += k;
+        vec->push(vec, k);
+    }
+    assert(vec->reduce(vec, 0, add_int) == total);
+
+    int parts = rand_int(1, 8), sum = 0;
+    view_sum = 0;
+    for (int part = 0; part < parts; ++part)
+    {
+        vector_int_view view = vec->slice(vec, limit * part / parts, limit * (part + 1) / parts);
+        sum += view.reduce(&view, 0, add_int);
+        view.foreach(&view, view_add);
+    }
+    assert(sum == total);
+    assert(view_sum == total);
+
+#ifndef NDEBUG
+    vector_int_view view = vec->slice(vec, 0, vec->size);
+    size_t max_size = vec->__max_size;
+    while (vec->__max_size == max_size)
+        vec->push(vec, 0);
+    assert(view.__generation != vec->__generation);
+#endif
+
+    vec->free_memory(vec);
+}
+
+void TEST11_SCOPED()
+{
+    printf("TEST: %s\n", __func__);
+    scoped vector_int *vec = new_vector_int();
+    int limit = rand_int(50, 500), total = 0;
+    for (int i = 0; i < limit; ++i)
+    {
+        int k = rand_int(-1000, 1000);
+        total += k;
+        vec->push(vec, k);
+    }
+    assert(vec->reduce(vec, 0, add_int) == total);
+
+    int parts = rand_int(1, 8), sum = 0;
+    view_sum = 0;
+    for (int part = 0; part < parts; ++part)
+    {
+        vector_int_view view = vec->slice(vec, limit * part / parts, limit * (part + 1) / parts);
+        sum += view.reduce(&view, 0, add_int);
+        view.foreach(&view, view_add);
+    }
+    assert(sum == total);
+    assert(view_sum == total);
+
+#ifndef NDEBUG
+    vector_int_view view = vec->slice(vec, 0, vec->size);
+    size_t max_size = vec->__max_size;
+    while (vec->__max_size == max_size)
+        vec->push(vec, 0);
+    assert(view.__generation != vec->__generation);
+#endif
+}
+
 int main()
 {
     srand(time(NULL));
@@ -353,6 +743,10 @@ int main()
     TEST5();
     TEST6();
     TEST7();
+    TEST8();
+    TEST9();
+    TEST10();
+    TEST11();
 
     TEST1_SCOPED();
     TEST2_SCOPED();
@@ -361,6 +755,10 @@ int main()
     TEST5_SCOPED();
     TEST6_SCOPED();
     TEST7_SCOPED();
+    TEST8_SCOPED();
+    TEST9_SCOPED();
+    TEST10_SCOPED();
+    TEST11_SCOPED();
 
     printf("All tests have been completed sucesfull\n");
     return 0;
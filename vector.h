@@ -1,12 +1,48 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
 
 #ifndef vector_h
 #define vector_h 1
 
 void _cleanup_universal(void *ptr);
 
+/**
+ * Every vector has a __generation field and every view remembers its parent and the generation
+ * it was created with, so the struct layout does not depend on NDEBUG. Debug builds bump the
+ * generation when the vector reallocates its data and assert on reads through an older view.
+ */
+#ifndef NDEBUG
+#define VECTOR_GENERATION_BUMP(__VEC__) ++(__VEC__)->__generation;
+#define VECTOR_VIEW_CHECK(__VIEW__) \
+    assert((__VIEW__)->__parent->__generation == (__VIEW__)->__generation && "view used after vector reallocated");
+#else
+#define VECTOR_GENERATION_BUMP(__VEC__)
+#define VECTOR_VIEW_CHECK(__VIEW__)
+#endif
+
+#define VECTOR_VIEW_STRUCT_DECLARATION(__TYPE__, __DECLARED_NAME__)                                           \
+    typedef struct __DECLARED_NAME__##_view __DECLARED_NAME__##_view;                                         \
+    struct __DECLARED_NAME__##_view                                                                           \
+    {                                                                                                         \
+        size_t size;                                                                                          \
+        size_t stride;                                                                                        \
+        __TYPE__ const *__data;                                                                               \
+        const struct __DECLARED_NAME__ *__parent;                                                             \
+        size_t __generation;                                                                                  \
+        int (*empty)(const __DECLARED_NAME__##_view *view);                                                   \
+        __TYPE__ (*at)(const __DECLARED_NAME__##_view *view, size_t index);                                   \
+        __TYPE__ (*front)(const __DECLARED_NAME__##_view *view);                                              \
+        __TYPE__ (*back)(const __DECLARED_NAME__##_view *view);                                               \
+        void (*foreach)(const __DECLARED_NAME__##_view *view, void (*function)(__TYPE__));                    \
+        size_t (*find)(const __DECLARED_NAME__##_view *view, __TYPE__ element);                               \
+        __TYPE__ (*reduce)(const __DECLARED_NAME__##_view *view, __TYPE__ initial,                            \
+                           __TYPE__ (*function)(__TYPE__, __TYPE__));                                         \
+        __DECLARED_NAME__##_view (*slice)(const __DECLARED_NAME__##_view *view, size_t begin, size_t end);    \
+        __DECLARED_NAME__##_view (*strided)(const __DECLARED_NAME__##_view *view, size_t begin, size_t step); \
+    };
+
 #define VECTOR_STRUCT_DECLARATION(__TYPE__, __DECLARED_NAME__)                   \
     typedef struct __DECLARED_NAME__ __DECLARED_NAME__;                          \
     struct __DECLARED_NAME__                                                     \
@@ -15,6 +51,7 @@ void _cleanup_universal(void *ptr);
         size_t size;                                                             \
         size_t __max_size;                                                       \
         __TYPE__ *__data;                                                        \
+        size_t __generation;                                                     \
         int (*empty)(__DECLARED_NAME__ * vec);                                   \
         int (*insert)(__DECLARED_NAME__ * vec, size_t index, __TYPE__ element);  \
         int (*push)(__DECLARED_NAME__ * vec, __TYPE__ element);                  \
@@ -30,6 +67,13 @@ void _cleanup_universal(void *ptr);
         int (*optimize_memory)(__DECLARED_NAME__ * vec);                         \
         void (*foreach)(__DECLARED_NAME__ * vec, void (*function)(__TYPE__));    \
         __DECLARED_NAME__ *(*clone)(const __DECLARED_NAME__ *vec);               \
+        size_t (*find)(__DECLARED_NAME__ * vec, __TYPE__ element);               \
+        __TYPE__ (*reduce)(__DECLARED_NAME__ * vec, __TYPE__ initial,            \
+                           __TYPE__ (*function)(__TYPE__, __TYPE__));            \
+        __DECLARED_NAME__##_view (*slice)(__DECLARED_NAME__ * vec,               \
+                                          size_t begin, size_t end);             \
+        __DECLARED_NAME__##_view (*strided)(__DECLARED_NAME__ * vec,             \
+                                            size_t begin, size_t step);          \
     };
 
 #define VECTOR_FUNCTION_PROTOTYPES(__TYPE__, __DECLARED_NAME__)                               \
@@ -46,9 +90,119 @@ void _cleanup_universal(void *ptr);
     __TYPE__ __front##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                              \
     __TYPE__ __back##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                               \
     void __foreach##__DECLARED_NAME__(__DECLARED_NAME__ *vec, void (*function)(__TYPE__));    \
+    size_t __find##__DECLARED_NAME__(__DECLARED_NAME__ *vec, __TYPE__ element);               \
+    __TYPE__ __reduce##__DECLARED_NAME__(__DECLARED_NAME__ *vec, __TYPE__ initial,            \
+                                         __TYPE__ (*function)(__TYPE__, __TYPE__));           \
+    __DECLARED_NAME__##_view __slice##__DECLARED_NAME__(__DECLARED_NAME__ *vec,               \
+                                                        size_t begin, size_t end);            \
+    __DECLARED_NAME__##_view __strided##__DECLARED_NAME__(__DECLARED_NAME__ *vec,             \
+                                                          size_t begin, size_t step);         \
     __DECLARED_NAME__ *sized_##__DECLARED_NAME__(size_t initial_size);                        \
     __DECLARED_NAME__ *new_##__DECLARED_NAME__();
 
+#define VECTOR_VIEW_FUNCTION_PROTOTYPES(__TYPE__, __DECLARED_NAME__)                                            \
+    int __empty##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view);                                \
+    __TYPE__ __at##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, size_t index);                \
+    __TYPE__ __front##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view);                           \
+    __TYPE__ __back##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view);                            \
+    void __foreach##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, void (*function)(__TYPE__)); \
+    size_t __find##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, __TYPE__ element);            \
+    __TYPE__ __reduce##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, __TYPE__ initial,         \
+                                                __TYPE__ (*function)(__TYPE__, __TYPE__));                      \
+    __DECLARED_NAME__##_view __slice##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view,            \
+                                                               size_t begin, size_t end);                       \
+    __DECLARED_NAME__##_view __strided##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view,          \
+                                                                 size_t begin, size_t step);                    \
+    __DECLARED_NAME__##_view new_##__DECLARED_NAME__##_view(const __DECLARED_NAME__ *vec, size_t begin,         \
+                                                            size_t size, size_t stride);
+
+#define VECTOR_VIEW_FUNCTION_DEFINITIONS(__TYPE__, __DECLARED_NAME__)                                          \
+    int __empty##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view)                                \
+    {                                                                                                          \
+        return view->size == 0;                                                                                \
+    }                                                                                                          \
+    __TYPE__ __at##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, size_t index)                \
+    {                                                                                                          \
+        assert(index < view->size);                                                                            \
+        VECTOR_VIEW_CHECK(view)                                                                                \
+        return view->__data[index * view->stride];                                                             \
+    }                                                                                                          \
+    __TYPE__ __front##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view)                           \
+    {                                                                                                          \
+        assert(view->size > 0);                                                                                \
+        return view->at(view, 0);                                                                              \
+    }                                                                                                          \
+    __TYPE__ __back##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view)                            \
+    {                                                                                                          \
+        assert(view->size > 0);                                                                                \
+        return view->at(view, view->size - 1);                                                                 \
+    }                                                                                                          \
+    void __foreach##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, void (*function)(__TYPE__)) \
+    {                                                                                                          \
+        VECTOR_VIEW_CHECK(view)                                                                                \
+        for (size_t i = 0; i < view->size; ++i)                                                                \
+            function(view->__data[i * view->stride]);                                                          \
+    }                                                                                                          \
+    size_t __find##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, __TYPE__ element)            \
+    {                                                                                                          \
+        VECTOR_VIEW_CHECK(view)                                                                                \
+        for (size_t i = 0; i < view->size; ++i)                                                                \
+            if (view->__data[i * view->stride] == element)                                                     \
+                return i;                                                                                      \
+        return view->size;                                                                                     \
+    }                                                                                                          \
+    __TYPE__ __reduce##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view, __TYPE__ initial,        \
+                                                __TYPE__ (*function)(__TYPE__, __TYPE__))                      \
+    {                                                                                                          \
+        VECTOR_VIEW_CHECK(view)                                                                                \
+        for (size_t i = 0; i < view->size; ++i)                                                                \
+            initial = function(initial, view->__data[i * view->stride]);                                       \
+        return initial;                                                                                        \
+    }                                                                                                          \
+    __DECLARED_NAME__##_view __slice##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view,           \
+                                                               size_t begin, size_t end)                       \
+    {                                                                                                          \
+        assert(begin <= end && end <= view->size);                                                             \
+        __DECLARED_NAME__##_view slice = *view;                                                                   \
+        /* An empty slice at the end keeps the old pointer, begin * stride is past the buffer */                  \
+        if (begin < view->size)                                                                                   \
+            slice.__data = view->__data + begin * view->stride;                                                   \
+        slice.size = end - begin;                                                                              \
+        return slice;                                                                                          \
+    }                                                                                                          \
+    __DECLARED_NAME__##_view __strided##__DECLARED_NAME__##_view(const __DECLARED_NAME__##_view *view,         \
+                                                                 size_t begin, size_t step)                    \
+    {                                                                                                          \
+        assert(step > 0 && begin <= view->size);                                                               \
+        __DECLARED_NAME__##_view strided = *view;                                                                 \
+        if (begin < view->size)                                                                                   \
+            strided.__data = view->__data + begin * view->stride;                                                 \
+        strided.size = view->size == begin ? 0 : (view->size - begin - 1) / step + 1;                          \
+        /* A second element exists only if step < view->size, then the product cannot overflow */              \
+        strided.stride = strided.size > 1 ? view->stride * step : view->stride;                                \
+        return strided;                                                                                        \
+    }                                                                                                          \
+    __DECLARED_NAME__##_view new_##__DECLARED_NAME__##_view(const __DECLARED_NAME__ *vec, size_t begin,        \
+                                                            size_t size, size_t stride)                        \
+    {                                                                                                          \
+        __DECLARED_NAME__##_view view = {0};                                                                   \
+        view.size = size;                                                                                      \
+        view.stride = stride;                                                                                  \
+        view.__data = vec->__data + begin;                                                                     \
+        view.__parent = vec;                                                                                   \
+        view.__generation = vec->__generation;                                                                 \
+        view.empty = __empty##__DECLARED_NAME__##_view;                                                        \
+        view.at = __at##__DECLARED_NAME__##_view;                                                              \
+        view.front = __front##__DECLARED_NAME__##_view;                                                        \
+        view.back = __back##__DECLARED_NAME__##_view;                                                          \
+        view.foreach = __foreach##__DECLARED_NAME__##_view;                                                    \
+        view.find = __find##__DECLARED_NAME__##_view;                                                          \
+        view.reduce = __reduce##__DECLARED_NAME__##_view;                                                      \
+        view.slice = __slice##__DECLARED_NAME__##_view;                                                        \
+        view.strided = __strided##__DECLARED_NAME__##_view;                                                    \
+        return view;                                                                                           \
+    }
+
 #define VECTOR_FUNCTION_DEFINITIONS(__TYPE__, __DECLARED_NAME__, __ELEMENT_CONSTRUCTOR__, __ELEMENT_DESTRUCTOR__) \
     int __add_memory##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                                   \
     {                                                                                                             \
@@ -60,6 +214,7 @@ void _cleanup_universal(void *ptr);
                 return 0;                                                                                         \
             vec->__data = data;                                                                                   \
             vec->__max_size = vec->__max_size * 2;                                                                \
+            VECTOR_GENERATION_BUMP(vec)                                                                           \
         }                                                                                                         \
         return 1;                                                                                                 \
     }                                                                                                             \
@@ -172,6 +327,31 @@ void _cleanup_universal(void *ptr);
         new_vec->size = vec->size;                                                                                \
         return new_vec;                                                                                           \
     }                                                                                                             \
+    size_t __find##__DECLARED_NAME__(__DECLARED_NAME__ *vec, __TYPE__ element)                                    \
+    {                                                                                                             \
+        for (size_t i = 0; i < vec->size; ++i)                                                                    \
+            if (vec->__data[i] == element)                                                                        \
+                return i;                                                                                         \
+        return vec->size;                                                                                         \
+    }                                                                                                             \
+    __TYPE__ __reduce##__DECLARED_NAME__(__DECLARED_NAME__ *vec, __TYPE__ initial,                                \
+                                         __TYPE__ (*function)(__TYPE__, __TYPE__))                                \
+    {                                                                                                             \
+        for (size_t i = 0; i < vec->size; ++i)                                                                    \
+            initial = function(initial, vec->__data[i]);                                                          \
+        return initial;                                                                                           \
+    }                                                                                                             \
+    __DECLARED_NAME__##_view __slice##__DECLARED_NAME__(__DECLARED_NAME__ *vec, size_t begin, size_t end)         \
+    {                                                                                                             \
+        assert(begin <= end && end <= vec->size);                                                                 \
+        return new_##__DECLARED_NAME__##_view(vec, begin, end - begin, 1);                                        \
+    }                                                                                                             \
+    __DECLARED_NAME__##_view __strided##__DECLARED_NAME__(__DECLARED_NAME__ *vec, size_t begin, size_t step)      \
+    {                                                                                                             \
+        assert(step > 0 && begin <= vec->size);                                                                   \
+        size_t size = vec->size == begin ? 0 : (vec->size - begin - 1) / step + 1;                                \
+        return new_##__DECLARED_NAME__##_view(vec, begin, size, step);                                            \
+    }                                                                                                             \
     int __optimize_memory##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                              \
     {                                                                                                             \
         if (vec->size == 0)                                                                                       \
@@ -181,6 +361,7 @@ void _cleanup_universal(void *ptr);
             return 0;                                                                                             \
         vec->__data = data;                                                                                       \
         vec->__max_size = vec->size;                                                                              \
+        VECTOR_GENERATION_BUMP(vec)                                                                               \
         return 1;                                                                                                 \
     }                                                                                                             \
     __DECLARED_NAME__ *sized_##__DECLARED_NAME__(size_t initial_size)                                             \
@@ -201,6 +382,10 @@ void _cleanup_universal(void *ptr);
         vec->element_destructor = __ELEMENT_DESTRUCTOR__;                                                         \
         vec->foreach = __foreach##__DECLARED_NAME__;                                                              \
         vec->clone = __clone##__DECLARED_NAME__;                                                                  \
+        vec->find = __find##__DECLARED_NAME__;                                                                    \
+        vec->reduce = __reduce##__DECLARED_NAME__;                                                                \
+        vec->slice = __slice##__DECLARED_NAME__;                                                                  \
+        vec->strided = __strided##__DECLARED_NAME__;                                                              \
         vec->size = 0;                                                                                            \
         vec->optimize_memory = __optimize_memory##__DECLARED_NAME__;                                              \
         vec->__max_size = initial_size;                                                                           \
@@ -255,13 +440,652 @@ void _cleanup_universal(void *ptr);
  * scoped vector_int *vec = new_vector_int();
  * ```
  *
+ * The macro also declares a read-only view type __DECLARED_NAME___view that shares the vector's data
+ * without copying it. Views are returned by value and need no free_memory:
+ * ```c
+ * vector_int_view head = vec->slice(vec, 0, 10);     // elements [0, 10)
+ * vector_int_view even = vec->strided(vec, 0, 2);    // elements 0, 2, 4, ...
+ * int a = head.at(&head, 3);                         // at, front, back, foreach, find, reduce, slice, strided
+ * ```
+ * A view is valid until the vector reallocates its data. Debug builds assert on a view used after that.
+ *
  * @return This macro defines the functions and struct declarations for the specified vector type.
  */
 #define VECTOR(__TYPE__, __DECLARED_NAME__, __ELEMENT_CONSTRUCTOR__, __ELEMENT_DESTRUCTOR__) \
+    VECTOR_VIEW_STRUCT_DECLARATION(__TYPE__, __DECLARED_NAME__)                              \
     VECTOR_STRUCT_DECLARATION(__TYPE__, __DECLARED_NAME__)                                   \
+    VECTOR_VIEW_FUNCTION_PROTOTYPES(__TYPE__, __DECLARED_NAME__)                             \
     VECTOR_FUNCTION_PROTOTYPES(__TYPE__, __DECLARED_NAME__)                                  \
+    VECTOR_VIEW_FUNCTION_DEFINITIONS(__TYPE__, __DECLARED_NAME__)                            \
     VECTOR_FUNCTION_DEFINITIONS(__TYPE__, __DECLARED_NAME__, __ELEMENT_CONSTRUCTOR__, __ELEMENT_DESTRUCTOR__)
 
+/**
+ * Number of values stored in one compressed block of a VECTOR_PACKED vector.
+ */
+#define VECTOR_PACKED_BLOCK 128
+#define VECTOR_PACKED_LANES 4
+#define VECTOR_PACKED_NARROW_LANES (2 * VECTOR_PACKED_LANES)
+/**
+ * DELTA blocks store the value at every VECTOR_PACKED_ANCHOR-th index in front of their packed
+ * data, so random access sums at most VECTOR_PACKED_ANCHOR - 1 deltas.
+ */
+#define VECTOR_PACKED_ANCHOR 16
+#define VECTOR_PACKED_ANCHORS (VECTOR_PACKED_BLOCK / VECTOR_PACKED_ANCHOR - 1)
+#define VECTOR_PACKED_FOR 0
+#define VECTOR_PACKED_DELTA 1
+
+/**
+ * Header of a single compressed block.
+ * FOR (frame of reference):  value[i] = reference + packed[i]
+ * DELTA:                     value[0] = base, value[i] = value[i - 1] + reference + packed[i]
+ *                            value[k * VECTOR_PACKED_ANCHOR] = base + anchor_min + anchor[k - 1] for k >= 1,
+ *                            anchors are bit-packed at anchor_width in front of the packed values
+ * All arithmetic is done on uint64_t, so it wraps instead of overflowing.
+ */
+typedef struct _packed_block
+{
+    uint64_t base;
+    uint64_t reference;
+    uint64_t anchor_min;
+    size_t offset;
+    unsigned char width;
+    unsigned char mode;
+    unsigned char anchor_width;
+} _packed_block;
+
+static inline unsigned _packed_bit_width(uint64_t range)
+{
+    unsigned width = 0;
+    while (range)
+    {
+        ++width;
+        range >>= 1;
+    }
+    return width;
+}
+
+static inline size_t _packed_words(size_t count, unsigned width)
+{
+    return (count * width + 63) / 64;
+}
+
+static inline void _packed_encode(uint64_t *out, const uint64_t *values, size_t count, unsigned width)
+{
+    memset(out, 0, _packed_words(count, width) * sizeof(uint64_t));
+    if (width == 0)
+        return;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t bit = i * width;
+        unsigned shift = bit & 63;
+        out[bit >> 6] |= values[i] << shift;
+        if (shift + width > 64)
+            out[(bit >> 6) + 1] |= values[i] >> (64 - shift);
+    }
+}
+
+/**
+ * Reads the value at `index` without branching on the bit position. The word after
+ * the value is always read, so the anchors are always followed by at least one word.
+ */
+static inline uint64_t _packed_extract(const uint64_t *in, size_t index, unsigned width)
+{
+    if (width == 0)
+        return 0;
+    size_t bit = index * width;
+    unsigned shift = bit & 63;
+    uint64_t value = (in[bit >> 6] >> shift) | ((in[(bit >> 6) + 1] << 1) << (63 - shift));
+    return width == 64 ? value : value & ((UINT64_C(1) << width) - 1);
+}
+
+/**
+ * Packed values of a block are interleaved over lanes: value i is stored in lane i % lanes as the
+ * (i / lanes)-th value of that lane, and word k of every lane is stored next to each other. One row
+ * of lanes then shares the same bit position, so it is unpacked with a few vector shifts. Types of
+ * at most 32 bits use VECTOR_PACKED_NARROW_LANES lanes of 32-bit words, wider types use
+ * VECTOR_PACKED_LANES lanes of 64-bit words. Narrow types never need more than 32 bits: the FOR
+ * range fits the type and DELTA is only chosen when it is narrower. A row is 32 bytes either way
+ * and a block of width w takes 4 * ceil(w / 2) words.
+ */
+static inline size_t _packed_lane_words(unsigned width)
+{
+    return VECTOR_PACKED_LANES * _packed_words(VECTOR_PACKED_BLOCK / VECTOR_PACKED_LANES, width);
+}
+
+static inline void _packed_encode_lanes(uint64_t *out, const uint64_t *values, unsigned width, int narrow)
+{
+    memset(out, 0, _packed_lane_words(width) * sizeof(uint64_t));
+    if (width == 0)
+        return;
+    if (narrow)
+    {
+        uint32_t words[VECTOR_PACKED_BLOCK] = {0};
+        for (size_t i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+        {
+            size_t lane = i % VECTOR_PACKED_NARROW_LANES;
+            size_t bit = i / VECTOR_PACKED_NARROW_LANES * width;
+            unsigned shift = bit & 31;
+            words[(bit >> 5) * VECTOR_PACKED_NARROW_LANES + lane] |= (uint32_t)(values[i] << shift);
+            if (shift + width > 32)
+                words[((bit >> 5) + 1) * VECTOR_PACKED_NARROW_LANES + lane] |= (uint32_t)(values[i] >> (32 - shift));
+        }
+        memcpy(out, words, _packed_lane_words(width) * sizeof(uint64_t));
+        return;
+    }
+    for (size_t i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+    {
+        size_t lane = i % VECTOR_PACKED_LANES;
+        size_t bit = i / VECTOR_PACKED_LANES * width;
+        unsigned shift = bit & 63;
+        out[(bit >> 6) * VECTOR_PACKED_LANES + lane] |= values[i] << shift;
+        if (shift + width > 64)
+            out[((bit >> 6) + 1) * VECTOR_PACKED_LANES + lane] |= values[i] >> (64 - shift);
+    }
+}
+
+/**
+ * Same as _packed_extract for the lane layout. The row after the value is always read,
+ * so the words buffer keeps VECTOR_PACKED_LANES spare words at its end.
+ */
+static inline uint64_t _packed_extract_lane(const uint64_t *in, size_t index, unsigned width, int narrow)
+{
+    if (width == 0)
+        return 0;
+    if (narrow)
+    {
+        const unsigned char *lane = (const unsigned char *)in + index % VECTOR_PACKED_NARROW_LANES * sizeof(uint32_t);
+        size_t bit = index / VECTOR_PACKED_NARROW_LANES * width;
+        unsigned shift = bit & 31;
+        uint32_t low, high;
+        memcpy(&low, lane + (bit >> 5) * VECTOR_PACKED_NARROW_LANES * sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&high, lane + ((bit >> 5) + 1) * VECTOR_PACKED_NARROW_LANES * sizeof(uint32_t), sizeof(uint32_t));
+        uint32_t value = (low >> shift) | ((high << 1) << (31 - shift));
+        return width == 32 ? value : value & ((UINT32_C(1) << width) - 1);
+    }
+    const uint64_t *lane = in + index % VECTOR_PACKED_LANES;
+    size_t bit = index / VECTOR_PACKED_LANES * width;
+    unsigned shift = bit & 63;
+    uint64_t value = (lane[(bit >> 6) * VECTOR_PACKED_LANES] >> shift) |
+                     ((lane[((bit >> 6) + 1) * VECTOR_PACKED_LANES] << 1) << (63 - shift));
+    return width == 64 ? value : value & ((UINT64_C(1) << width) - 1);
+}
+
+static inline const uint64_t *_packed_data(const _packed_block *block, const uint64_t *words)
+{
+    if (block->mode == VECTOR_PACKED_FOR)
+        return words + block->offset;
+    return words + block->offset + _packed_words(VECTOR_PACKED_ANCHORS, block->anchor_width);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef uint32_t _packed_narrow_row __attribute__((vector_size(VECTOR_PACKED_NARROW_LANES * sizeof(uint32_t))));
+typedef uint64_t _packed_row __attribute__((vector_size(VECTOR_PACKED_LANES * sizeof(uint64_t))));
+#if !defined(__clang__)
+typedef int32_t _packed_narrow_index __attribute__((vector_size(VECTOR_PACKED_NARROW_LANES * sizeof(int32_t))));
+typedef int64_t _packed_index __attribute__((vector_size(VECTOR_PACKED_LANES * sizeof(int64_t))));
+#endif
+
+/**
+ * Inclusive prefix sum of a row, computed with log2(lanes) shifted adds instead of
+ * a serial add per lane.
+ */
+static inline void _packed_narrow_scan(_packed_narrow_row *row)
+{
+    _packed_narrow_row zero = {0};
+#if defined(__clang__)
+    *row += __builtin_shufflevector(*row, zero, 8, 0, 1, 2, 3, 4, 5, 6);
+    *row += __builtin_shufflevector(*row, zero, 8, 8, 0, 1, 2, 3, 4, 5);
+    *row += __builtin_shufflevector(*row, zero, 8, 8, 8, 8, 0, 1, 2, 3);
+#else
+    *row += __builtin_shuffle(*row, zero, (_packed_narrow_index){8, 0, 1, 2, 3, 4, 5, 6});
+    *row += __builtin_shuffle(*row, zero, (_packed_narrow_index){8, 8, 0, 1, 2, 3, 4, 5});
+    *row += __builtin_shuffle(*row, zero, (_packed_narrow_index){8, 8, 8, 8, 0, 1, 2, 3});
+#endif
+}
+
+static inline void _packed_scan(_packed_row *row)
+{
+    _packed_row zero = {0};
+#if defined(__clang__)
+    *row += __builtin_shufflevector(*row, zero, 4, 0, 1, 2);
+    *row += __builtin_shufflevector(*row, zero, 4, 4, 0, 1);
+#else
+    *row += __builtin_shuffle(*row, zero, (_packed_index){4, 0, 1, 2});
+    *row += __builtin_shuffle(*row, zero, (_packed_index){4, 4, 0, 1});
+#endif
+}
+#endif
+
+/**
+ * Decodes a whole block of 32-bit lanes into `out` as 32-bit values, every value is written
+ * once. With GCC and Clang each row is unpacked, offset by the FOR reference and, for DELTA
+ * blocks, prefix summed in vector registers. Other compilers use the equivalent scalar loop.
+ */
+static inline void _packed_decode_narrow(const _packed_block *block, const uint64_t *words, void *out)
+{
+    const unsigned char *in = (const unsigned char *)_packed_data(block, words);
+    unsigned char *bytes = (unsigned char *)out;
+    unsigned width = block->width;
+    uint32_t mask = width == 32 ? ~UINT32_C(0) : (UINT32_C(1) << width) - 1;
+    uint32_t reference = (uint32_t)block->reference;
+    uint32_t running = (uint32_t)block->base - reference;
+    int delta = block->mode == VECTOR_PACKED_DELTA;
+    if (width == 0)
+    {
+        for (size_t i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+        {
+            running += reference;
+            uint32_t value = delta ? running : reference;
+            memcpy(bytes + i * sizeof(value), &value, sizeof(value));
+        }
+        return;
+    }
+    for (size_t row = 0; row < VECTOR_PACKED_BLOCK / VECTOR_PACKED_NARROW_LANES; ++row)
+    {
+        size_t bit = row * width;
+        unsigned shift = bit & 31;
+        const unsigned char *low = in + (bit >> 5) * VECTOR_PACKED_NARROW_LANES * sizeof(uint32_t);
+        const unsigned char *high = low + VECTOR_PACKED_NARROW_LANES * sizeof(uint32_t);
+#if defined(__GNUC__) || defined(__clang__)
+        _packed_narrow_row low_row, high_row, value;
+        memcpy(&low_row, low, sizeof(value));
+        memcpy(&high_row, high, sizeof(value));
+        value = (((low_row >> shift) | ((high_row << 1) << (31 - shift))) & mask) + reference;
+        if (delta)
+        {
+            _packed_narrow_scan(&value);
+            value += running;
+            running = value[VECTOR_PACKED_NARROW_LANES - 1];
+        }
+#else
+        uint32_t value[VECTOR_PACKED_NARROW_LANES];
+        for (size_t lane = 0; lane < VECTOR_PACKED_NARROW_LANES; ++lane)
+        {
+            uint32_t low_word, high_word;
+            memcpy(&low_word, low + lane * sizeof(uint32_t), sizeof(uint32_t));
+            memcpy(&high_word, high + lane * sizeof(uint32_t), sizeof(uint32_t));
+            value[lane] = (((low_word >> shift) | ((high_word << 1) << (31 - shift))) & mask) + reference;
+            if (delta)
+            {
+                running += value[lane];
+                value[lane] = running;
+            }
+        }
+#endif
+        memcpy(bytes + row * sizeof(value), &value, sizeof(value));
+    }
+}
+
+/**
+ * Same as _packed_decode_narrow for blocks of 64-bit lanes, `out` receives 64-bit values.
+ */
+static inline void _packed_decode_wide(const _packed_block *block, const uint64_t *words, void *out)
+{
+    const uint64_t *in = _packed_data(block, words);
+    unsigned char *bytes = (unsigned char *)out;
+    unsigned width = block->width;
+    uint64_t mask = width == 64 ? ~UINT64_C(0) : (UINT64_C(1) << width) - 1;
+    uint64_t reference = block->reference;
+    uint64_t running = block->base - reference;
+    int delta = block->mode == VECTOR_PACKED_DELTA;
+    if (width == 0)
+    {
+        for (size_t i = 0; i < VECTOR_PACKED_BLOCK; ++i)
+        {
+            running += reference;
+            uint64_t value = delta ? running : reference;
+            memcpy(bytes + i * sizeof(value), &value, sizeof(value));
+        }
+        return;
+    }
+    for (size_t row = 0; row < VECTOR_PACKED_BLOCK / VECTOR_PACKED_LANES; ++row)
+    {
+        size_t bit = row * width;
+        unsigned shift = bit & 63;
+        const uint64_t *low = in + (bit >> 6) * VECTOR_PACKED_LANES;
+        const uint64_t *high = low + VECTOR_PACKED_LANES;
+#if defined(__GNUC__) || defined(__clang__)
+        _packed_row low_row, high_row, value;
+        memcpy(&low_row, low, sizeof(value));
+        memcpy(&high_row, high, sizeof(value));
+        value = (((low_row >> shift) | ((high_row << 1) << (63 - shift))) & mask) + reference;
+        if (delta)
+        {
+            _packed_scan(&value);
+            value += running;
+            running = value[VECTOR_PACKED_LANES - 1];
+        }
+#else
+        uint64_t value[VECTOR_PACKED_LANES];
+        for (size_t lane = 0; lane < VECTOR_PACKED_LANES; ++lane)
+        {
+            value[lane] = (((low[lane] >> shift) | ((high[lane] << 1) << (63 - shift))) & mask) + reference;
+            if (delta)
+            {
+                running += value[lane];
+                value[lane] = running;
+            }
+        }
+#endif
+        memcpy(bytes + row * sizeof(value), &value, sizeof(value));
+    }
+}
+
+/**
+ * Random access inside a block. FOR blocks extract a single value, DELTA blocks start
+ * from the nearest anchor and sum at most VECTOR_PACKED_ANCHOR - 1 packed deltas.
+ */
+static inline uint64_t _packed_get(const _packed_block *block, const uint64_t *words, size_t index, int narrow)
+{
+    const uint64_t *in = _packed_data(block, words);
+    if (block->mode == VECTOR_PACKED_FOR)
+        return block->reference + _packed_extract_lane(in, index, block->width, narrow);
+
+    size_t anchor = index / VECTOR_PACKED_ANCHOR;
+    uint64_t value = block->base;
+    if (anchor > 0)
+        value += block->anchor_min + _packed_extract(words + block->offset, anchor - 1, block->anchor_width);
+    for (size_t i = anchor * VECTOR_PACKED_ANCHOR + 1; i <= index; ++i)
+        value += block->reference + _packed_extract_lane(in, i, block->width, narrow);
+    return value;
+}
+
+#define VECTOR_PACKED_STRUCT_DECLARATION(__TYPE__, __DECLARED_NAME__)           \
+    typedef struct __DECLARED_NAME__ __DECLARED_NAME__;                         \
+    struct __DECLARED_NAME__                                                    \
+    {                                                                           \
+        void (*free_memory)(__DECLARED_NAME__ * vec);                           \
+        size_t size;                                                            \
+        size_t __blocks_size;                                                   \
+        size_t __blocks_max_size;                                               \
+        _packed_block *__blocks;                                                \
+        size_t __words_size;                                                    \
+        size_t __words_max_size;                                                \
+        uint64_t *__words;                                                      \
+        __TYPE__ __tail[VECTOR_PACKED_BLOCK];                                   \
+        int (*empty)(__DECLARED_NAME__ * vec);                                  \
+        int (*push)(__DECLARED_NAME__ * vec, __TYPE__ element);                 \
+        __TYPE__ (*at)(__DECLARED_NAME__ * vec, size_t index);                  \
+        __TYPE__ (*front)(__DECLARED_NAME__ * vec);                             \
+        __TYPE__ (*back)(__DECLARED_NAME__ * vec);                              \
+        void (*clear)(__DECLARED_NAME__ * vec);                                 \
+        int (*optimize_memory)(__DECLARED_NAME__ * vec);                        \
+        size_t (*memory_usage)(const __DECLARED_NAME__ *vec);                   \
+        void (*foreach)(__DECLARED_NAME__ * vec, void (*function)(__TYPE__));   \
+        size_t (*decode)(__DECLARED_NAME__ * vec, size_t block, __TYPE__ *out); \
+    };
+
+#define VECTOR_PACKED_FUNCTION_PROTOTYPES(__TYPE__, __DECLARED_NAME__)                       \
+    int __flush##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                                  \
+    void __free_memory##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                           \
+    int __empty##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                                  \
+    int __push##__DECLARED_NAME__(__DECLARED_NAME__ *vec, __TYPE__ element);                 \
+    __TYPE__ __at##__DECLARED_NAME__(__DECLARED_NAME__ *vec, size_t index);                  \
+    __TYPE__ __front##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                             \
+    __TYPE__ __back##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                              \
+    void __clear##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                                 \
+    int __optimize_memory##__DECLARED_NAME__(__DECLARED_NAME__ *vec);                        \
+    size_t __memory_usage##__DECLARED_NAME__(const __DECLARED_NAME__ *vec);                  \
+    void __foreach##__DECLARED_NAME__(__DECLARED_NAME__ *vec, void (*function)(__TYPE__));   \
+    size_t __decode##__DECLARED_NAME__(__DECLARED_NAME__ *vec, size_t block, __TYPE__ *out); \
+    __DECLARED_NAME__ *new_##__DECLARED_NAME__();
+
+#define VECTOR_PACKED_FUNCTION_DEFINITIONS(__TYPE__, __DECLARED_NAME__)                                           \
+    int __flush##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                                        \
+    {                                                                                                             \
+        const __TYPE__ *tail = vec->__tail;                                                                       \
+        uint64_t values[VECTOR_PACKED_BLOCK];                                                                     \
+        __TYPE__ min = tail[0], max = tail[0];                                                                    \
+        int64_t min_delta = (int64_t)((uint64_t)tail[1] - (uint64_t)tail[0]), max_delta = min_delta;              \
+        for (size_t i = 1; i < VECTOR_PACKED_BLOCK; ++i)                                                          \
+        {                                                                                                         \
+            int64_t delta = (int64_t)((uint64_t)tail[i] - (uint64_t)tail[i - 1]);                                 \
+            if (tail[i] < min)                                                                                    \
+                min = tail[i];                                                                                    \
+            if (tail[i] > max)                                                                                    \
+                max = tail[i];                                                                                    \
+            if (delta < min_delta)                                                                                \
+                min_delta = delta;                                                                                \
+            if (delta > max_delta)                                                                                \
+                max_delta = delta;                                                                                \
+        }                                                                                                         \
+        unsigned for_width = _packed_bit_width((uint64_t)max - (uint64_t)min);                                    \
+        unsigned delta_width = _packed_bit_width((uint64_t)max_delta - (uint64_t)min_delta);                      \
+        int64_t min_anchor = (int64_t)((uint64_t)tail[VECTOR_PACKED_ANCHOR] - (uint64_t)tail[0]);                 \
+        int64_t max_anchor = min_anchor;                                                                          \
+        for (size_t k = 2; k <= VECTOR_PACKED_ANCHORS; ++k)                                                       \
+        {                                                                                                         \
+            int64_t anchor = (int64_t)((uint64_t)tail[k * VECTOR_PACKED_ANCHOR] - (uint64_t)tail[0]);             \
+            if (anchor < min_anchor)                                                                              \
+                min_anchor = anchor;                                                                              \
+            if (anchor > max_anchor)                                                                              \
+                max_anchor = anchor;                                                                              \
+        }                                                                                                         \
+        unsigned anchor_width = _packed_bit_width((uint64_t)max_anchor - (uint64_t)min_anchor);                   \
+        size_t anchor_words = _packed_words(VECTOR_PACKED_ANCHORS, anchor_width);                                 \
+                                                                                                                  \
+        _packed_block block = {0};                                                                                \
+        uint64_t anchors[VECTOR_PACKED_ANCHORS];                                                                  \
+        if (anchor_words + _packed_lane_words(delta_width) < _packed_lane_words(for_width))                       \
+        {                                                                                                         \
+            block.mode = VECTOR_PACKED_DELTA;                                                                     \
+            block.width = delta_width;                                                                            \
+            block.base = (uint64_t)tail[0];                                                                       \
+            block.reference = (uint64_t)min_delta;                                                                \
+            block.anchor_min = (uint64_t)min_anchor;                                                              \
+            block.anchor_width = anchor_width;                                                                    \
+            values[0] = 0;                                                                                        \
+            for (size_t i = 1; i < VECTOR_PACKED_BLOCK; ++i)                                                      \
+                values[i] = (uint64_t)tail[i] - (uint64_t)tail[i - 1] - block.reference;                          \
+            for (size_t k = 1; k <= VECTOR_PACKED_ANCHORS; ++k)                                                   \
+                anchors[k - 1] = (uint64_t)tail[k * VECTOR_PACKED_ANCHOR] - block.base - block.anchor_min;        \
+        }                                                                                                         \
+        else                                                                                                      \
+        {                                                                                                         \
+            block.mode = VECTOR_PACKED_FOR;                                                                       \
+            block.width = for_width;                                                                              \
+            block.reference = (uint64_t)min;                                                                      \
+            for (size_t i = 0; i < VECTOR_PACKED_BLOCK; ++i)                                                      \
+                values[i] = (uint64_t)tail[i] - block.reference;                                                  \
+            anchor_words = 0;                                                                                     \
+        }                                                                                                         \
+                                                                                                                  \
+        if (vec->__blocks_size + 1 > vec->__blocks_max_size)                                                      \
+        {                                                                                                         \
+            _packed_block *blocks = (_packed_block *)realloc(vec->__blocks,                                       \
+                                                             vec->__blocks_max_size * 2 * sizeof(_packed_block)); \
+            if (blocks == NULL)                                                                                   \
+                return 0;                                                                                         \
+            vec->__blocks = blocks;                                                                               \
+            vec->__blocks_max_size = vec->__blocks_max_size * 2;                                                  \
+        }                                                                                                         \
+        size_t words_needed = anchor_words + _packed_lane_words(block.width);                                     \
+        if (vec->__words_size + words_needed + VECTOR_PACKED_LANES > vec->__words_max_size)                       \
+        {                                                                                                         \
+            size_t new_max_size = vec->__words_max_size;                                                          \
+            while (vec->__words_size + words_needed + VECTOR_PACKED_LANES > new_max_size)                         \
+                new_max_size *= 2;                                                                                \
+            uint64_t *words = (uint64_t *)realloc(vec->__words, new_max_size * sizeof(uint64_t));                 \
+            if (words == NULL)                                                                                    \
+                return 0;                                                                                         \
+            vec->__words = words;                                                                                 \
+            vec->__words_max_size = new_max_size;                                                                 \
+        }                                                                                                         \
+                                                                                                                  \
+        block.offset = vec->__words_size;                                                                         \
+        if (block.mode == VECTOR_PACKED_DELTA)                                                                    \
+            _packed_encode(vec->__words + block.offset, anchors, VECTOR_PACKED_ANCHORS, block.anchor_width);      \
+        _packed_encode_lanes(vec->__words + block.offset + anchor_words, values, block.width,                     \
+                             sizeof(__TYPE__) <= sizeof(uint32_t));                                               \
+        vec->__words_size += words_needed;                                                                        \
+        memset(vec->__words + vec->__words_size, 0, VECTOR_PACKED_LANES * sizeof(uint64_t));                      \
+        vec->__blocks[vec->__blocks_size++] = block;                                                              \
+        return 1;                                                                                                 \
+    }                                                                                                             \
+    void __free_memory##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                                 \
+    {                                                                                                             \
+        if (vec == NULL)                                                                                          \
+        {                                                                                                         \
+            return;                                                                                               \
+        }                                                                                                         \
+        free(vec->__blocks);                                                                                      \
+        free(vec->__words);                                                                                       \
+        free(vec);                                                                                                \
+    }                                                                                                             \
+    int __empty##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                                        \
+    {                                                                                                             \
+        return vec->size == 0;                                                                                    \
+    }                                                                                                             \
+    int __push##__DECLARED_NAME__(__DECLARED_NAME__ *vec, __TYPE__ element)                                       \
+    {                                                                                                             \
+        size_t tail_size = vec->size - vec->__blocks_size * VECTOR_PACKED_BLOCK;                                  \
+        vec->__tail[tail_size] = element;                                                                         \
+        if (tail_size + 1 == VECTOR_PACKED_BLOCK && !__flush##__DECLARED_NAME__(vec))                             \
+            return 0;                                                                                             \
+        ++vec->size;                                                                                              \
+        return 1;                                                                                                 \
+    }                                                                                                             \
+    __TYPE__ __at##__DECLARED_NAME__(__DECLARED_NAME__ *vec, size_t index)                                        \
+    {                                                                                                             \
+        assert(index < vec->size);                                                                                \
+        size_t block = index / VECTOR_PACKED_BLOCK;                                                               \
+        if (block == vec->__blocks_size)                                                                          \
+            return vec->__tail[index % VECTOR_PACKED_BLOCK];                                                      \
+        return (__TYPE__)_packed_get(&vec->__blocks[block], vec->__words, index % VECTOR_PACKED_BLOCK,            \
+                                     sizeof(__TYPE__) <= sizeof(uint32_t));                                       \
+    }                                                                                                             \
+    __TYPE__ __front##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                                   \
+    {                                                                                                             \
+        assert(vec->size > 0);                                                                                    \
+        return vec->at(vec, 0);                                                                                   \
+    }                                                                                                             \
+    __TYPE__ __back##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                                    \
+    {                                                                                                             \
+        assert(vec->size > 0);                                                                                    \
+        return vec->at(vec, vec->size - 1);                                                                       \
+    }                                                                                                             \
+    void __clear##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                                       \
+    {                                                                                                             \
+        vec->size = 0;                                                                                            \
+        vec->__blocks_size = 0;                                                                                   \
+        vec->__words_size = 0;                                                                                    \
+    }                                                                                                             \
+    int __optimize_memory##__DECLARED_NAME__(__DECLARED_NAME__ *vec)                                              \
+    {                                                                                                             \
+        if (vec->__blocks_size > 0)                                                                               \
+        {                                                                                                         \
+            _packed_block *blocks = realloc(vec->__blocks, sizeof(_packed_block) * vec->__blocks_size);           \
+            if (blocks == NULL)                                                                                   \
+                return 0;                                                                                         \
+            vec->__blocks = blocks;                                                                               \
+            vec->__blocks_max_size = vec->__blocks_size;                                                          \
+        }                                                                                                         \
+        uint64_t *words = realloc(vec->__words, sizeof(uint64_t) * (vec->__words_size + VECTOR_PACKED_LANES));    \
+        if (words == NULL)                                                                                        \
+            return 0;                                                                                             \
+        vec->__words = words;                                                                                     \
+        vec->__words_max_size = vec->__words_size + VECTOR_PACKED_LANES;                                          \
+        return 1;                                                                                                 \
+    }                                                                                                             \
+    size_t __memory_usage##__DECLARED_NAME__(const __DECLARED_NAME__ *vec)                                        \
+    {                                                                                                             \
+        return sizeof(__DECLARED_NAME__) + vec->__blocks_max_size * sizeof(_packed_block) +                       \
+               vec->__words_max_size * sizeof(uint64_t);                                                          \
+    }                                                                                                             \
+    size_t __decode##__DECLARED_NAME__(__DECLARED_NAME__ *vec, size_t block, __TYPE__ *out)                       \
+    {                                                                                                             \
+        assert(block * VECTOR_PACKED_BLOCK < vec->size);                                                          \
+        if (block == vec->__blocks_size)                                                                          \
+        {                                                                                                         \
+            size_t count = vec->size - block * VECTOR_PACKED_BLOCK;                                               \
+            memcpy(out, vec->__tail, count * sizeof(__TYPE__));                                                   \
+            return count;                                                                                         \
+        }                                                                                                         \
+        if (sizeof(__TYPE__) == sizeof(uint64_t))                                                                 \
+            _packed_decode_wide(&vec->__blocks[block], vec->__words, out);                                        \
+        else if (sizeof(__TYPE__) == sizeof(uint32_t))                                                            \
+            _packed_decode_narrow(&vec->__blocks[block], vec->__words, out);                                      \
+        else                                                                                                      \
+        {                                                                                                         \
+            uint32_t values[VECTOR_PACKED_BLOCK];                                                                 \
+            _packed_decode_narrow(&vec->__blocks[block], vec->__words, values);                                   \
+            for (size_t i = 0; i < VECTOR_PACKED_BLOCK; ++i)                                                      \
+                out[i] = (__TYPE__)values[i];                                                                     \
+        }                                                                                                         \
+        return VECTOR_PACKED_BLOCK;                                                                               \
+    }                                                                                                             \
+    void __foreach##__DECLARED_NAME__(__DECLARED_NAME__ *vec, void (*function)(__TYPE__))                         \
+    {                                                                                                             \
+        __TYPE__ values[VECTOR_PACKED_BLOCK];                                                                     \
+        for (size_t block = 0; block * VECTOR_PACKED_BLOCK < vec->size; ++block)                                  \
+        {                                                                                                         \
+            size_t count = vec->decode(vec, block, values);                                                       \
+            for (size_t i = 0; i < count; ++i)                                                                    \
+                function(values[i]);                                                                              \
+        }                                                                                                         \
+    }                                                                                                             \
+    __DECLARED_NAME__ *new_##__DECLARED_NAME__()                                                                  \
+    {                                                                                                             \
+        __DECLARED_NAME__ *vec = (__DECLARED_NAME__ *)calloc(1, sizeof(__DECLARED_NAME__));                       \
+        if (vec == NULL)                                                                                          \
+            return NULL;                                                                                          \
+        vec->free_memory = __free_memory##__DECLARED_NAME__;                                                      \
+        vec->empty = __empty##__DECLARED_NAME__;                                                                  \
+        vec->push = __push##__DECLARED_NAME__;                                                                    \
+        vec->at = __at##__DECLARED_NAME__;                                                                        \
+        vec->front = __front##__DECLARED_NAME__;                                                                  \
+        vec->back = __back##__DECLARED_NAME__;                                                                    \
+        vec->clear = __clear##__DECLARED_NAME__;                                                                  \
+        vec->optimize_memory = __optimize_memory##__DECLARED_NAME__;                                              \
+        vec->memory_usage = __memory_usage##__DECLARED_NAME__;                                                    \
+        vec->foreach = __foreach##__DECLARED_NAME__;                                                              \
+        vec->decode = __decode##__DECLARED_NAME__;                                                                \
+        vec->size = 0;                                                                                            \
+        vec->__blocks_max_size = 2;                                                                               \
+        vec->__blocks = (_packed_block *)malloc(sizeof(_packed_block) * vec->__blocks_max_size);                  \
+        vec->__words_max_size = 2;                                                                                \
+        vec->__words = (uint64_t *)malloc(sizeof(uint64_t) * vec->__words_max_size);                              \
+        if (vec->__blocks == NULL || vec->__words == NULL)                                                        \
+        {                                                                                                         \
+            vec->free_memory(vec);                                                                                \
+            return NULL;                                                                                          \
+        }                                                                                                         \
+        return vec;                                                                                               \
+    }
+/**
+ * VECTOR_PACKED macro should be called in global scope, not inside functions.
+ * It declares an append-only vector of integers that is stored compressed.
+ *
+ * Values are collected in blocks of VECTOR_PACKED_BLOCK (128) elements. A full block is encoded
+ * either as frame of reference (value - block minimum) or as delta from the previous value,
+ * whichever takes fewer words, and bit-packed at that minimum width. Sorted data such as
+ * timestamps or ids usually needs only a few bits per value.
+ *
+ * Usage:
+ * ```c
+ *  VECTOR_PACKED(long long, vector_packed_long);
+ *  vector_packed_long *vec = new_vector_packed_long();
+ *  vec->push(vec, 1700000000000);      // push at end of vector
+ *  long long a = vec->at(vec, 0);      // random access locates the block through its header
+ *  vec->foreach(vec, function);        // decodes whole blocks, one call per element
+ *  vec->decode(vec, 0, values);        // copies block 0 into values, fastest way to scan
+ *  vec->free_memory(vec);              // free allocated memory
+ * ```
+ *
+ * @param __TYPE__                   Integer type of stored element, at most 64 bits wide e.g. int, long, unsigned.
+ * @param __DECLARED_NAME__          Name of vector declaration e.g. vector_packed_int.
+ *                                   Used as: __DECLARED_NAME__ *vec = new___DECLARED_NAME__().
+ *
+ * Elements cannot be inserted, replaced or popped, only pushed or cleared.
+ * The `scoped` macro works the same way as for VECTOR.
+ *
+ * @return This macro defines the functions and struct declarations for the specified packed vector type.
+ */
+#define VECTOR_PACKED(__TYPE__, __DECLARED_NAME__)                 \
+    VECTOR_PACKED_STRUCT_DECLARATION(__TYPE__, __DECLARED_NAME__)  \
+    VECTOR_PACKED_FUNCTION_PROTOTYPES(__TYPE__, __DECLARED_NAME__) \
+    VECTOR_PACKED_FUNCTION_DEFINITIONS(__TYPE__, __DECLARED_NAME__)
+
 #if defined(__GNUC__) || defined(__clang__)
 /**
  * Predefined for automatic cleanup